@@ -0,0 +1,60 @@
+/**
+ * Project: BIN project
+ * Author: Tomáš Kučma
+ * Year: 2022/2023
+ * Description: Contains definition of types and declaration of functions used
+ *  for function blocks [And-Inverter Graph variant]
+ */
+
+#ifndef AIG_FUNCTION_HPP
+#define AIG_FUNCTION_HPP
+
+#include "function.hpp"
+#include "types.hpp"
+#include <array>
+
+// Function set of AND blocks with optionally inverted inputs (AIG)
+struct AigFunctionSet {
+    static constexpr const char *name = "aig";
+    static constexpr size_t BLOCK_IN_COUNT = 2;
+    static constexpr size_t COST = 1;
+    static constexpr size_t MAX_BLOCK_COST = COST;
+
+    using BlockInput = std::array<Bitmap, BLOCK_IN_COUNT>;
+
+    // digits denote polarity of the inputs (0 for inverted input)
+    enum Function {
+        AND_00,
+        AND_01,
+        AND_10,
+        AND_11,
+        FUNCTION_COUNT,
+    };
+
+    static constexpr size_t function_in_count(const Function &function) {
+        return 2;
+    }
+
+    // returns cost assigned to a given function block
+    static constexpr size_t function_cost(const Function &function) {
+        return COST;
+    }
+
+    static constexpr Bitmap simulate_function(const BlockInput &inputs,
+                                              const Function &function) {
+        switch (function) {
+        case AND_00:
+            return ~inputs[0] & ~inputs[1];
+        case AND_01:
+            return ~inputs[0] & inputs[1];
+        case AND_10:
+            return inputs[0] & ~inputs[1];
+        case AND_11:
+            return inputs[0] & inputs[1];
+        default:
+            throw FunctionError(function);
+        }
+    }
+};
+
+#endif // AIG_FUNCTION_HPP
@@ -8,12 +8,19 @@
 
 #include "cgp.hpp"
 #include "function.hpp"
+#include "library.hpp"
+#include <algorithm>
 #include <bit>
+#include <cmath>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
-void CGP::validate_parameters() {
+template <typename FunctionSet, typename Gene>
+void CGP<FunctionSet, Gene>::validate_parameters() {
     if (!in_count) {
         throw std::invalid_argument("Input count 0\n");
     }
@@ -44,7 +51,8 @@ void CGP::validate_parameters() {
     }
 }
 
-std::vector<std::vector<Bitmap>> CGP::generate_input() {
+template <typename FunctionSet, typename Gene>
+std::vector<std::vector<Bitmap>> CGP<FunctionSet, Gene>::generate_input() {
     std::vector<std::vector<Bitmap>> ins(in_count,
                                          std::vector<Bitmap>(bitmap_count));
     for (size_t i = 0; i < in_count; i++) {
@@ -67,7 +75,8 @@ std::vector<std::vector<Bitmap>> CGP::generate_input() {
     return ins;
 }
 
-std::vector<std::vector<Gene>> CGP::generate_col_values() {
+template <typename FunctionSet, typename Gene>
+std::vector<std::vector<Gene>> CGP<FunctionSet, Gene>::generate_col_values() {
     std::vector<std::vector<Gene>> col_values(cols);
     for (size_t col = 0; col < cols; col++) {
         size_t minidx = std::max(rows * (col - l_back) + in_count, in_count);
@@ -86,35 +95,46 @@ std::vector<std::vector<Gene>> CGP::generate_col_values() {
     return col_values;
 }
 
-std::ostream &CGP::print_parameters() {
+template <typename FunctionSet, typename Gene>
+CGPConfig CGP<FunctionSet, Gene>::config() const {
+    return {in_count, expected_outs, cols, rows, l_back, lambda,
+            mutation_max_count, adaptive_mutation};
+}
+
+template <typename FunctionSet, typename Gene>
+std::ostream &CGP<FunctionSet, Gene>::print_parameters() {
     out << "Parameters: (" << in_count << "," << out_count << ", " << cols
         << "," << rows << ", " << BLOCK_IN_COUNT << "," << l_back << ", "
-        << lambda << "+1," << mutation_max_count << ")";
+        << lambda << "+1," << mutation_max_count
+        << (adaptive_mutation ? " adaptive" : "") << ")";
     return out;
 }
 
-std::ostream &CGP::print_chromosome(const Chromosome &chromosome) {
+template <typename FunctionSet, typename Gene>
+std::ostream &
+CGP<FunctionSet, Gene>::print_chromosome(const Chromosome &chromosome) {
     auto chrom_iter = chromosome.cbegin();
     // function blocks
     for (size_t j = 0; j < block_count; j++, chrom_iter++) {
         out << "([" << j + in_count << "],";
         // inputs
         for (size_t k = 0; k < BLOCK_IN_COUNT; k++, chrom_iter++) {
-            out << *chrom_iter << ",";
+            out << +*chrom_iter << ",";
         }
         // function
-        out << *chrom_iter << ")";
+        out << +*chrom_iter << ")";
     }
     out << "(";
     // output
     for (size_t j = 0; j < out_count; j++, chrom_iter++) {
-        out << (j ? "," : "") << *chrom_iter;
+        out << (j ? "," : "") << +*chrom_iter;
     }
     out << ")";
     return out;
 }
 
-std::ostream &CGP::print_fitness(const size_t &fitness) {
+template <typename FunctionSet, typename Gene>
+std::ostream &CGP<FunctionSet, Gene>::print_fitness(const size_t &fitness) {
     if (max_fitness <= fitness) {
         out << max_fitness << "/" << max_fitness << " (block cost "
             << max_fitness + block_count * MAX_BLOCK_COST - fitness << "/"
@@ -125,14 +145,17 @@ std::ostream &CGP::print_fitness(const size_t &fitness) {
     return out;
 }
 
-std::ostream &CGP::print_population() {
+template <typename FunctionSet, typename Gene>
+std::ostream &CGP<FunctionSet, Gene>::print_population() {
     for (const auto &chromosome : population) {
         print_chromosome(chromosome) << "\n";
     }
     return out;
 }
 
-size_t CGP::get_used_block_cost(const Chromosome &chromosome) {
+template <typename FunctionSet, typename Gene>
+size_t
+CGP<FunctionSet, Gene>::get_used_block_cost(const Chromosome &chromosome) {
     size_t used_block_cost = 0;
     std::vector<bool> used_blocks(block_count, false); // ! std::vector<bool>
     // out << "size = " << chromosome_size << ", blocks" << blocks
@@ -143,13 +166,13 @@ size_t CGP::get_used_block_cost(const Chromosome &chromosome) {
         if ((i >= chromosome_size - out_count || // if output,
              (used_blocks[i / BLOCK_SIZE] &&     // or if active block
               i % BLOCK_SIZE <                   // and is input,
-                  function_in_count(static_cast<Function>(
+                  FunctionSet::function_in_count(static_cast<Function>(
                       chromosome[i - i % BLOCK_SIZE + BLOCK_IN_COUNT])))) &&
             chromosome[i] >= in_count) { // then if connected to another block:
             auto block = used_blocks[chromosome[i] - in_count]; // reference
             used_block_cost +=
                 !block *
-                function_cost(static_cast<Function>(
+                FunctionSet::function_cost(static_cast<Function>(
                     chromosome[(chromosome[i] - in_count) * BLOCK_SIZE +
                                BLOCK_IN_COUNT]));
             block = true;
@@ -160,7 +183,8 @@ size_t CGP::get_used_block_cost(const Chromosome &chromosome) {
     return used_block_cost;
 }
 
-size_t CGP::get_fitness(const Chromosome &chromosome) {
+template <typename FunctionSet, typename Gene>
+size_t CGP<FunctionSet, Gene>::get_fitness(const Chromosome &chromosome) {
     size_t fitness = 0;
     for (size_t i = 0; i < bitmap_count; i++) {
         auto value_iter = current_values.begin();
@@ -176,7 +200,7 @@ size_t CGP::get_fitness(const Chromosome &chromosome) {
                 input = current_values[*chromosome_iter++];
             }
             Function function = Function(*chromosome_iter++);
-            *value_iter = simulate_function(inputs, function);
+            *value_iter = FunctionSet::simulate_function(inputs, function);
         }
         // output
         for (const auto &out : expected_outs) {
@@ -195,42 +219,83 @@ size_t CGP::get_fitness(const Chromosome &chromosome) {
     return fitness;
 }
 
-void CGP::mutate(Chromosome &chromosome) {
+template <typename FunctionSet, typename Gene>
+bool CGP<FunctionSet, Gene>::is_valid_chromosome(
+    const std::vector<::Gene> &genes) {
+    if (genes.size() != chromosome_size) {
+        return false;
+    }
+    auto gene_iter = genes.begin();
+    // function blocks, connected only to inputs or blocks in earlier columns
+    for (size_t j = 0; j < block_count; j++, gene_iter++) {
+        for (size_t k = 0; k < BLOCK_IN_COUNT; k++, gene_iter++) {
+            if (*gene_iter >= in_count + (j / rows) * rows) {
+                return false;
+            }
+        }
+        if (*gene_iter >= FUNCTION_COUNT) {
+            return false;
+        }
+    }
+    // output
+    return std::all_of(gene_iter, genes.end(), [&](const ::Gene &gene) {
+        return gene < in_count + block_count;
+    });
+}
+
+template <typename FunctionSet, typename Gene>
+size_t CGP<FunctionSet, Gene>::get_mutation_max_count() {
+    return adaptive_mutation ? std::lround(mutation_strength)
+                             : mutation_max_count;
+}
+
+template <typename FunctionSet, typename Gene>
+void CGP<FunctionSet, Gene>::mutate(Chromosome &chromosome) {
     // out << "mutating\n"; // DEBUG
-    size_t mutate_count = (rand() % mutation_max_count) + 1;
+    size_t mutate_count = (random_engine() % get_mutation_max_count()) + 1;
     for (size_t j = 0; j < mutate_count; j++) {
-        size_t i = rand() % chromosome_size;
+        size_t i = random_engine() % chromosome_size;
         size_t col = i / (rows * BLOCK_SIZE);
         // out << "i=" << i << ", col=" << col << "\n"; // DEBUG
 
         if (i < chromosome_size - out_count) { // block mutation
+            const size_t value = random_engine();
             chromosome[i] =
                 (i % BLOCK_SIZE) < BLOCK_IN_COUNT
-                    ? col_values[col][rand() % col_values[col].size()]
-                    : rand() % FUNCTION_COUNT;
+                    ? col_values[col][value % col_values[col].size()]
+                    : value % FUNCTION_COUNT;
 // out << ((i % BLOCK_SIZE) < BLOCK_IN_COUNT
 //                   ? "block"
 //                   : "function")
 //           << " thus " << chromosome[i] << "\n"; // DEBUG
-#ifndef STANDARD_VARIANT
             theorem1(chromosome, i);
-#endif           // STANDARD_VARIANT
         } else { // output mutation
-            chromosome[i] = rand() % (block_count + in_count);
+            chromosome[i] = random_engine() % (block_count + in_count);
         }
     }
 }
 
-std::tuple<size_t, const Chromosome &>
-CGP::get_best_chromosome(const Chromosome *const parent_ptr) {
+template <typename FunctionSet, typename Gene>
+auto CGP<FunctionSet, Gene>::get_best_chromosome(
+    const Chromosome *const parent_ptr, const size_t parent_fitness)
+    -> std::tuple<size_t, const Chromosome &> {
+    auto count_offspring = [&](const Chromosome &chromosome, size_t fitness) {
+        if (parent_ptr && &chromosome != parent_ptr) {
+            offspring_counts[fitness > parent_fitness   ? 0
+                             : fitness == parent_fitness ? 1
+                                                         : 2]++;
+        }
+    };
     auto best_chromosome = population.begin();
     size_t best_fitness = get_fitness(*best_chromosome);
+    count_offspring(*best_chromosome, best_fitness);
     // out << "default best is "
     //           << (&*best_chromosome == parent_ptr ? "" : "not ")
     //           << "parent\n"; // DEBUG
     for (auto chrom_iter = population.begin() + 1;
          chrom_iter != population.end(); chrom_iter++) {
         size_t fitness = get_fitness(*chrom_iter);
+        count_offspring(*chrom_iter, fitness);
         if (fitness > best_fitness ||
             (fitness == best_fitness &&
              //  (out << "checking if parent in best chromosome\n",
@@ -246,7 +311,48 @@ CGP::get_best_chromosome(const Chromosome *const parent_ptr) {
     return std::tie(best_fitness, *best_chromosome);
 }
 
-void CGP::generate_default_population() {
+template <typename FunctionSet, typename Gene>
+void CGP<FunctionSet, Gene>::adapt_mutation_strength(size_t generation) {
+    const size_t offspring_count =
+        offspring_counts[0] + offspring_counts[1] + offspring_counts[2];
+    if (!adaptive_mutation ||
+        offspring_count < MUTATION_ADAPTATION_PERIOD * lambda) {
+        return;
+    }
+    const double success_ratio =
+        double(offspring_counts[0] + offspring_counts[1]) / offspring_count;
+    if (success_ratio > MUTATION_SUCCESS_RATIO) {
+        mutation_strength *= MUTATION_STRENGTH_INCREASE;
+    } else if (success_ratio < MUTATION_SUCCESS_RATIO) {
+        mutation_strength *= MUTATION_STRENGTH_DECREASE;
+    }
+    mutation_strength =
+        std::clamp(mutation_strength, 1.0, double(chromosome_size));
+    for (size_t i = 0; i < offspring_counts.size(); i++) {
+        logged_offspring_counts[i] += offspring_counts[i];
+    }
+    offspring_counts = {};
+    log_mutation_count(generation);
+}
+
+template <typename FunctionSet, typename Gene>
+void CGP<FunctionSet, Gene>::log_mutation_count(size_t generation,
+                                                bool force) {
+    if (get_mutation_max_count() == logged_mutation_max_count ||
+        (!force && generation < logged_generation + MUTATION_LOG_PERIOD)) {
+        return;
+    }
+    out << "Mutation " << generation << ": " << logged_offspring_counts[0]
+        << "/" << logged_offspring_counts[1] << "/"
+        << logged_offspring_counts[2] << " -> " << get_mutation_max_count()
+        << "\n";
+    logged_offspring_counts = {};
+    logged_generation = generation;
+    logged_mutation_max_count = get_mutation_max_count();
+}
+
+template <typename FunctionSet, typename Gene>
+void CGP<FunctionSet, Gene>::generate_default_population() {
     for (auto &chromosome : population) {
         auto gene_iter = chromosome.begin();
         // function blocks
@@ -254,20 +360,21 @@ void CGP::generate_default_population() {
             size_t col = (j / rows);
             // inputs
             for (size_t k = 0; k < BLOCK_IN_COUNT; k++, gene_iter++) {
-                *gene_iter =
-                    col_values[col][(rand() % (col_values[col].size()))];
+                *gene_iter = col_values[col][random_engine() %
+                                             col_values[col].size()];
             }
             // function
-            *gene_iter = rand() % FUNCTION_COUNT;
+            *gene_iter = random_engine() % FUNCTION_COUNT;
         }
         // output
         for (size_t j = 0; j < out_count; j++, gene_iter++) {
-            *gene_iter = rand() % (in_count + block_count);
+            *gene_iter = random_engine() % (in_count + block_count);
         }
     }
 }
 
-void CGP::generate_new_population(const Chromosome &parent) {
+template <typename FunctionSet, typename Gene>
+void CGP<FunctionSet, Gene>::generate_new_population(const Chromosome &parent) {
     for (auto &chromosome : population) {
         if (&chromosome != &parent) {
             chromosome = parent;
@@ -278,107 +385,317 @@ void CGP::generate_new_population(const Chromosome &parent) {
     }
 }
 
-std::tuple<size_t, const Chromosome &> CGP::run_evolution(size_t iter_count) {
+template <typename FunctionSet, typename Gene>
+auto CGP<FunctionSet, Gene>::run_evolution(size_t iter_count,
+                                           const Chromosome *seed_ptr,
+                                           const size_t target_fitness)
+    -> std::tuple<size_t, const Chromosome &> {
     print_parameters() << "\n\n";
+    Chromosome library_seed;
+    if (!seed_ptr && library && library_seeding) {
+        // the seed is used only if it really is a solution, as a safeguard
+        // against damaged library entries or ones not matching the outputs
+        auto genes = library->find(FunctionSet::name, config(), ins);
+        if (genes && is_valid_chromosome(*genes)) {
+            library_seed.assign(genes->begin(), genes->end());
+            if (get_fitness(library_seed) >= max_fitness) {
+                out << "Library seed\n";
+                seed_ptr = &library_seed;
+            }
+        }
+    }
+    mutation_strength = mutation_max_count;
+    offspring_counts = {};
+    logged_offspring_counts = {};
+    logged_generation = 0;
+    logged_mutation_max_count = mutation_max_count;
+    solution_generation = iter_count;
     generate_default_population();
+    if (seed_ptr) { // start from mutations of the given chromosome
+        population.front() = *seed_ptr;
+        generate_new_population(population.front());
+    }
     // print_population() << "\n";  // DEBUG
 
     size_t parent_fitness = 0;
     const Chromosome *parent_ptr = nullptr;
     out << "Generation: chromosome, fitness\n"; // DEBUG
     for (size_t generation = 0; generation < iter_count; generation++) {
-        auto [new_fitness, new_parent] = get_best_chromosome(parent_ptr);
+        auto [new_fitness, new_parent] =
+            get_best_chromosome(parent_ptr, parent_fitness);
         if (new_fitness > parent_fitness) {
             out << generation << ": ";
             print_chromosome(new_parent) << ", ";
             print_fitness(new_fitness) << "\n";
         }
+        if (new_fitness >= max_fitness && parent_fitness < max_fitness) {
+            solution_generation = generation;
+            // neutral offspring count as successes, which keeps drift going
+            // while searching for a solution, but makes the mutation count
+            // grow too large for minimizing its cost, so the default one is
+            // used from now on
+            if (adaptive_mutation) {
+                mutation_strength = mutation_max_count;
+                log_mutation_count(generation, true);
+            }
+        }
+        if (new_fitness < max_fitness) {
+            adapt_mutation_strength(generation);
+        }
         parent_fitness = new_fitness;
         parent_ptr = &new_parent;
+        if (parent_fitness >= target_fitness) {
+            break;
+        }
         generate_new_population(*parent_ptr);
         // print_population() << "\n"; // DEBUG
     }
-    return get_best_chromosome();
+    auto best = get_best_chromosome();
+    auto [best_fitness, best_chromosome] = best;
+    if (library && best_fitness >= max_fitness) {
+        library->add(FunctionSet::name, config(), ins, best_fitness,
+                     {best_chromosome.begin(), best_chromosome.end()});
+    }
+    return best;
 }
 
-#ifndef STANDARD_VARIANT
-void CGP::theorem1(Chromosome chromosome, size_t function_index) {
-    // out << "theorem1\n";            // DEBUG
-    // print_chromosome(chromosome) << "\n"; // DEBUG
-    size_t index = function_index - BLOCK_IN_COUNT;
+template <typename FunctionSet, typename Gene>
+std::vector<std::tuple<size_t, size_t, size_t>>
+CGP<FunctionSet, Gene>::get_decomposition(size_t group_size) {
+    group_size = std::max(group_size, 1UL);
+    // each group needs a band of at least DECOMPOSITION_MIN_ROWS rows, as
+    // narrower bands rarely converge
+    const size_t max_group_count =
+        std::max(rows / DECOMPOSITION_MIN_ROWS, 1UL);
+    group_size = std::max(group_size,
+                          (out_count + max_group_count - 1) / max_group_count);
+    const size_t group_count = (out_count + group_size - 1) / group_size;
 
-    // check if the function index is actually a function index
-    if (index % BLOCK_SIZE != 0) {
-        return;
+    std::vector<std::tuple<size_t, size_t, size_t>> groups;
+    size_t first_out = 0;
+    for (size_t g = 0; g < group_count; g++) {
+        const size_t group_outs = std::min(group_size, out_count - first_out);
+        const size_t group_rows = rows / group_count + (g < rows % group_count);
+        groups.emplace_back(first_out, group_outs, group_rows);
+        first_out += group_outs;
     }
+    return groups;
+}
 
-    // check if the chosen block is maj function block
-    Function function = static_cast<Function>(chromosome[function_index]);
-    if (!is_maj(function)) {
-        return;
+template <typename FunctionSet, typename Gene>
+auto CGP<FunctionSet, Gene>::run_decomposed_evolution(size_t iter_count,
+                                                      size_t group_size)
+    -> std::tuple<size_t, const Chromosome &> {
+    const auto groups = get_decomposition(group_size);
+    std::vector<std::vector<std::vector<Bitmap>>> group_expected_outs;
+    for (const auto &[first_out, group_outs, group_rows] : groups) {
+        group_expected_outs.emplace_back(
+            expected_outs.begin() + first_out,
+            expected_outs.begin() + first_out + group_outs);
     }
 
-    // check if its children are xor function blocks
-    std::array<size_t, function_in_count(MAJ_111)> in_indexes{};
-    for (size_t i = 0; i < in_indexes.size(); index++, i++) {
-        if (chromosome[index] < in_count) {
+    // evolve each group of outputs on its own part of the grid (a band of
+    // rows), in parallel, until it's functionally correct or its part of the
+    // iterations is used up
+    const size_t group_iter_count =
+        std::max(size_t(iter_count * DECOMPOSITION_ITERATION_RATIO), 1UL);
+    std::vector<std::ostringstream> group_logs(groups.size());
+    std::vector<Chromosome> group_chromosomes(groups.size());
+    // generations used by each group (its iteration count if not solved) and
+    // its best fitness, each thread writing only its own elements
+    std::vector<size_t> group_generation_counts(groups.size());
+    std::vector<size_t> group_fitnesses(groups.size());
+    // seeds are drawn beforehand, so that they don't depend on thread timing
+    std::vector<std::minstd_rand::result_type> group_seeds(groups.size());
+    for (auto &seed : group_seeds) {
+        seed = random_engine();
+    }
+    std::vector<std::thread> threads;
+    for (size_t g = 0; g < groups.size(); g++) {
+        threads.emplace_back([&, g]() {
+            CGP group_cgp(in_count, group_expected_outs[g], cols,
+                          std::get<2>(groups[g]), l_back, lambda,
+                          mutation_max_count, adaptive_mutation,
+                          group_logs[g]);
+            group_cgp.library = library;
+            group_cgp.library_seeding = library_seeding;
+            group_cgp.random_engine.seed(group_seeds[g]);
+            auto [fitness, chromosome] = group_cgp.run_evolution(
+                group_iter_count, nullptr, group_cgp.max_fitness);
+            group_chromosomes[g] = chromosome;
+            group_fitnesses[g] = fitness;
+            group_generation_counts[g] =
+                fitness >= group_cgp.max_fitness
+                    ? group_cgp.solution_generation + 1
+                    : group_iter_count;
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (size_t g = 0; g < groups.size(); g++) {
+        const auto &[first_out, group_outs, group_rows] = groups[g];
+        out << "Decomposition: outputs " << first_out << "-"
+            << first_out + group_outs - 1 << ", " << group_rows
+            << " rows\n";
+        out << group_logs[g].str() << "\n";
+    }
+    // the groups run in parallel, so the group phase takes as many
+    // generations as the longest group
+    const size_t group_generation_count = *std::max_element(
+        group_generation_counts.begin(), group_generation_counts.end());
+    const size_t joint_iter_count = iter_count - group_generation_count;
+    // a group is solved once its fitness reaches the maximal one of its
+    // outputs
+    bool groups_solved = true;
+    for (size_t g = 0; g < groups.size(); g++) {
+        groups_solved &=
+            group_fitnesses[g] >= std::get<1>(groups[g]) * bit_count;
+    }
+    if (!groups_solved) {
+        out << "Joint evolution after " << group_generation_count
+            << " generations, not all groups solved\n";
+        auto best = run_evolution(joint_iter_count);
+        solution_generation += group_generation_count;
+        return best;
+    }
+
+    // merge the partial solutions by stacking their rows into a single grid
+    Chromosome merged(chromosome_size);
+    size_t first_row = 0;
+    for (size_t g = 0; g < groups.size(); g++) {
+        const auto &[first_out, group_outs, group_rows] = groups[g];
+        const auto &group_chromosome = group_chromosomes[g];
+        auto merge_gene = [&](const Gene &gene) -> Gene {
+            if (gene < in_count) {
+                return gene;
+            }
+            const size_t block = gene - in_count;
+            return in_count + (block / group_rows) * rows + first_row +
+                   block % group_rows;
+        };
+        for (size_t j = 0; j < cols * group_rows; j++) {
+            const size_t block = (j / group_rows) * rows + first_row +
+                                 j % group_rows;
+            for (size_t k = 0; k < BLOCK_IN_COUNT; k++) {
+                merged[block * BLOCK_SIZE + k] =
+                    merge_gene(group_chromosome[j * BLOCK_SIZE + k]);
+            }
+            merged[block * BLOCK_SIZE + BLOCK_IN_COUNT] =
+                group_chromosome[j * BLOCK_SIZE + BLOCK_IN_COUNT];
+        }
+        for (size_t j = 0; j < group_outs; j++) {
+            merged[block_count * BLOCK_SIZE + first_out + j] = merge_gene(
+                group_chromosome[cols * group_rows * BLOCK_SIZE + j]);
+        }
+        first_row += group_rows;
+    }
+
+    // joint phase sharing blocks between the outputs and minimizing the cost
+    out << "Joint evolution after " << group_generation_count
+        << " generations\n";
+    auto best = run_evolution(joint_iter_count, &merged);
+    solution_generation += group_generation_count;
+    return best;
+}
+
+template <typename FunctionSet, typename Gene>
+void CGP<FunctionSet, Gene>::theorem1(Chromosome chromosome,
+                                      size_t function_index) {
+    if constexpr (!std::is_same_v<FunctionSet, XmgFunctionSet>) {
+        return;
+    } else {
+        using enum XmgFunctionSet::Function;
+        using FS = XmgFunctionSet;
+        // out << "theorem1\n";            // DEBUG
+        // print_chromosome(chromosome) << "\n"; // DEBUG
+        size_t index = function_index - BLOCK_IN_COUNT;
+
+        // check if the function index is actually a function index
+        if (index % BLOCK_SIZE != 0) {
             return;
         }
-        in_indexes[i] = (chromosome[index] - in_count) * BLOCK_SIZE;
-        function =
-            static_cast<Function>(chromosome[in_indexes[i] + BLOCK_IN_COUNT]);
-        if (!is_xor(function)) {
+
+        // check if the chosen block is maj function block
+        Function function = static_cast<Function>(chromosome[function_index]);
+        if (!FS::is_maj(function)) {
             return;
         }
-    }
 
-    // check if its children share at least one input
-    const size_t invalid_value = in_count + block_count;
-    size_t shared_in{invalid_value};
-    std::array<size_t, function_in_count(MAJ_111)> remaining_ins{};
-    for (size_t i = 0; i < function_in_count(XOR_11); i++) {
-        for (size_t j = 0; j < function_in_count(XOR_11); j++) {
-            if (chromosome[in_indexes[0] + i] !=
-                chromosome[in_indexes[1] + j]) {
-                continue;
+        // check if its children are xor function blocks
+        std::array<size_t, FS::function_in_count(MAJ_111)> in_indexes{};
+        for (size_t i = 0; i < in_indexes.size(); index++, i++) {
+            if (chromosome[index] < in_count) {
+                return;
             }
-            for (size_t k = 0; k < function_in_count(XOR_11); k++) {
+            in_indexes[i] = (chromosome[index] - in_count) * BLOCK_SIZE;
+            function = static_cast<Function>(
+                chromosome[in_indexes[i] + BLOCK_IN_COUNT]);
+            if (!FS::is_xor(function)) {
+                return;
+            }
+        }
+
+        // check if its children share at least one input
+        const size_t invalid_value = in_count + block_count;
+        size_t shared_in{invalid_value};
+        std::array<size_t, FS::function_in_count(MAJ_111)> remaining_ins{};
+        for (size_t i = 0; i < FS::function_in_count(XOR_11); i++) {
+            for (size_t j = 0; j < FS::function_in_count(XOR_11); j++) {
                 if (chromosome[in_indexes[0] + i] !=
-                    chromosome[in_indexes[2] + k]) {
+                    chromosome[in_indexes[1] + j]) {
                     continue;
                 }
-                remaining_ins = {chromosome[in_indexes[0] + 1 - i],
-                                 chromosome[in_indexes[1] + 1 - j],
-                                 chromosome[in_indexes[2] + 1 - k]};
-                shared_in = chromosome[in_indexes[0] + i];
+                for (size_t k = 0; k < FS::function_in_count(XOR_11); k++) {
+                    if (chromosome[in_indexes[0] + i] !=
+                        chromosome[in_indexes[2] + k]) {
+                        continue;
+                    }
+                    remaining_ins = {chromosome[in_indexes[0] + 1 - i],
+                                     chromosome[in_indexes[1] + 1 - j],
+                                     chromosome[in_indexes[2] + 1 - k]};
+                    shared_in = chromosome[in_indexes[0] + i];
+                }
             }
         }
-    }
-    if (shared_in == invalid_value) {
-        return;
-    }
+        if (shared_in == invalid_value) {
+            return;
+        }
+
+        // perform replacement using theorem 1
+        // first by replacing one of the xor blocks with maj block
+        size_t max_index =
+            *std::max_element(std::begin(in_indexes), std::end(in_indexes));
+        chromosome[max_index + BLOCK_IN_COUNT] = function;
+        for (size_t i = 0; i < remaining_ins.size(); i++) {
+            chromosome[max_index + i] = remaining_ins[i];
+        }
+        index = function_index - BLOCK_IN_COUNT;
+        // then by replacing the maj block with xor block
+        chromosome[function_index] = XOR_11;
+        chromosome[index] = shared_in;
+        chromosome[index + 1] = max_index / BLOCK_SIZE + in_count;
+
+        // Note: this tranformation may change polarity of the remaining
+        // inputs, as it doesn't take into account the original XOR polarities.
+        // However it is expected to be called after mutation, when a random
+        // function (with random polarity) was chosen, so re-randomizing the
+        // polarity has no negative impact
 
-    // perform replacement using theorem 1
-    // first by replacing one of the xor blocks with maj block
-    size_t max_index =
-        *std::max_element(std::begin(in_indexes), std::end(in_indexes));
-    chromosome[max_index + BLOCK_IN_COUNT] = function;
-    for (size_t i = 0; i < remaining_ins.size(); i++) {
-        chromosome[max_index + i] = remaining_ins[i];
-    }
-    index = function_index - BLOCK_IN_COUNT;
-    // then by replacing the maj block with xor block
-    chromosome[function_index] = XOR_11;
-    chromosome[index] = shared_in;
-    chromosome[index + 1] = max_index / BLOCK_SIZE + in_count;
-
-    // Note: this tranformation may change polarity of the remaining inputs, as
-    // it doesn't take into account the original XOR polarities. However it is
-    // expected to be called after mutation, when a random function (with random
-    // polarity) was chosen, so re-randomizing the polarity has no negative
-    // impact
-
-    // out << "theorem1 done\n";                 // DEBUG
-    // print_chromosome(chromosome) << "\n";           // DEBUG
+        // out << "theorem1 done\n";                 // DEBUG
+        // print_chromosome(chromosome) << "\n";           // DEBUG
+    }
 }
-#endif // STANDARD_VARIANT
+
+template struct CGP<XmgFunctionSet, uint8_t>;
+template struct CGP<XmgFunctionSet, uint16_t>;
+template struct CGP<XmgFunctionSet, uint32_t>;
+template struct CGP<StandardFunctionSet, uint8_t>;
+template struct CGP<StandardFunctionSet, uint16_t>;
+template struct CGP<StandardFunctionSet, uint32_t>;
+template struct CGP<AigFunctionSet, uint8_t>;
+template struct CGP<AigFunctionSet, uint16_t>;
+template struct CGP<AigFunctionSet, uint32_t>;
+template struct CGP<MigFunctionSet, uint8_t>;
+template struct CGP<MigFunctionSet, uint16_t>;
+template struct CGP<MigFunctionSet, uint32_t>;
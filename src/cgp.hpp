@@ -9,14 +9,19 @@
 #ifndef CGP_HPP
 #define CGP_HPP
 
+#include "aig_function.hpp"
 #include "function.hpp"
+#include "mig_function.hpp"
+#include "standard_function.hpp"
 #include "types.hpp"
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <tuple>
 #include <vector>
 
-constexpr size_t BLOCK_SIZE = BLOCK_IN_COUNT + 1;
-
 // default CGP parameters
 constexpr size_t COLS = 5;
 constexpr size_t ROWS = 5;
@@ -25,12 +30,52 @@ constexpr size_t LAMBDA = 10;
 constexpr size_t IN_COUNT = 7;
 constexpr size_t ITERATION_COUNT = 1000;
 constexpr size_t MUTATION_MAX_COUNT = 10;
+constexpr bool ADAPTIVE_MUTATION = false;
+// 1/5th success rule for adaptive mutation (offspring not worse than their
+// parent count as a success), applied after given amount of generations until
+// the maximal fitness is reached, changes are logged at most once per given
+// amount of generations
+constexpr size_t MUTATION_ADAPTATION_PERIOD = 10;
+constexpr size_t MUTATION_LOG_PERIOD = 1000;
+constexpr double MUTATION_SUCCESS_RATIO = 1.0 / 5;
+constexpr double MUTATION_STRENGTH_DECREASE = 0.82;
+constexpr double MUTATION_STRENGTH_INCREASE = 1 / MUTATION_STRENGTH_DECREASE;
+// decomposition gives each group of outputs a band of at least given amount of
+// rows and at most given part of the iterations, after which it falls back to
+// joint evolution from scratch unless all groups are functionally correct
+constexpr size_t DECOMPOSITION_MIN_ROWS = 2;
+constexpr double DECOMPOSITION_ITERATION_RATIO = 0.75;
 const std::vector<std::vector<Bitmap>> EXPECTED_OUTS{
     {0x00000000FFFF0000U, 0xFFFFFFFFFFFFFFFFU},
     {0x0000000000000000U, 0x0000000000000000U},
     {0x00000000FFFFFFFFU, 0x00000000FFFFFFFFU}};
 
-struct CGP {
+struct Library;
+
+// CGP parameters independent of the function set used
+struct CGPConfig {
+    size_t in_count = IN_COUNT;
+    const std::vector<std::vector<Bitmap>> &expected_outs = EXPECTED_OUTS;
+    size_t cols = COLS;
+    size_t rows = ROWS;
+    size_t l_back = L_BACK;
+    size_t lambda = LAMBDA;
+    size_t mutation_max_count = MUTATION_MAX_COUNT;
+    bool adaptive_mutation = ADAPTIVE_MUTATION;
+};
+
+// CGP specialized for a given function set (e.g. XmgFunctionSet), so that the
+// evaluation of the function blocks doesn't need any runtime dispatch, and for
+// a given gene type (uint8_t, uint16_t or uint32_t), which has to be able to
+// index all nodes of the grid, so that the population is kept small
+template <typename FunctionSet, typename Gene> struct CGP {
+
+    using Chromosome = std::vector<Gene>;
+    using Function = typename FunctionSet::Function;
+    static constexpr size_t BLOCK_IN_COUNT = FunctionSet::BLOCK_IN_COUNT;
+    static constexpr size_t BLOCK_SIZE = BLOCK_IN_COUNT + 1;
+    static constexpr size_t MAX_BLOCK_COST = FunctionSet::MAX_BLOCK_COST;
+    static constexpr size_t FUNCTION_COUNT = FunctionSet::FUNCTION_COUNT;
 
     // Parameters
 
@@ -42,6 +87,7 @@ struct CGP {
     const size_t l_back;
     const size_t lambda;
     const size_t mutation_max_count;
+    const bool adaptive_mutation;
     std::ostream &out;
 
     // Internal data
@@ -55,6 +101,27 @@ struct CGP {
     std::vector<std::vector<Gene>> col_values;
     std::vector<Chromosome> population;
     std::vector<Bitmap> current_values;
+    // mutation count limit, adapted during evolution if adaptive mutation used
+    double mutation_strength;
+    // amounts of improving, neutral and worsening offspring since the last
+    // adaptation of mutation strength
+    std::array<size_t, 3> offspring_counts;
+    // the same amounts since the last logged change of the mutation count, and
+    // the generation and mutation count logged last
+    std::array<size_t, 3> logged_offspring_counts;
+    size_t logged_generation;
+    size_t logged_mutation_max_count;
+    // generation of the last evolution in which the maximal fitness was first
+    // reached (its iteration count if never), including the group phase of
+    // decomposed evolution
+    size_t solution_generation;
+    // library used for seeding evolution (unless disabled) and storing
+    // solutions (if any)
+    Library *library = nullptr;
+    bool library_seeding = true;
+    // random engine of this CGP only, so that CGPs running in parallel don't
+    // contend for a shared one and runs are reproducible from their seed
+    std::minstd_rand random_engine;
 
     // Initialization
 
@@ -66,10 +133,12 @@ struct CGP {
         const std::vector<std::vector<Bitmap>> &expected_outs = EXPECTED_OUTS,
         size_t cols = COLS, size_t rows = ROWS, size_t l_back = L_BACK,
         size_t lambda = LAMBDA, size_t mutation_max_count = MUTATION_MAX_COUNT,
+        bool adaptive_mutation = ADAPTIVE_MUTATION,
         std::ostream &out = std::cout)
         : in_count{in_count}, out_count{expected_outs.size()},
           expected_outs{expected_outs}, cols{cols}, rows{rows}, l_back{l_back},
-          lambda{lambda}, mutation_max_count{mutation_max_count}, out{out},
+          lambda{lambda}, mutation_max_count{mutation_max_count},
+          adaptive_mutation{adaptive_mutation}, out{out},
           bit_count{1UL << in_count},
           bitmap_count{std::max(bit_count / BITMAP_SIZE, 1UL)},
           max_fitness{out_count * bit_count}, ins(generate_input()),
@@ -77,11 +146,22 @@ struct CGP {
           chromosome_size{block_count * BLOCK_SIZE + out_count},
           col_values(generate_col_values()),
           population(lambda + 1, Chromosome(chromosome_size)),
-          current_values(in_count + block_count) {
+          current_values(in_count + block_count),
+          mutation_strength(mutation_max_count), offspring_counts{},
+          logged_offspring_counts{}, logged_generation{0},
+          logged_mutation_max_count{mutation_max_count},
+          solution_generation{0} {
 
         validate_parameters();
     };
 
+    CGP(const CGPConfig &config, std::ostream &out = std::cout)
+        : CGP(config.in_count, config.expected_outs, config.cols, config.rows,
+              config.l_back, config.lambda, config.mutation_max_count,
+              config.adaptive_mutation, out){};
+
+    CGPConfig config() const;
+
     // Output
 
     std::ostream &print_parameters();
@@ -93,16 +173,79 @@ struct CGP {
 
     size_t get_used_block_cost(const Chromosome &chromosome);
     size_t get_fitness(const Chromosome &chromosome);
+    // returns whether genes (e.g. of a library entry) form a chromosome of
+    // this CGP, i.e. have the right amount and all are in range
+    bool is_valid_chromosome(const std::vector<::Gene> &genes);
+    size_t get_mutation_max_count();
     void mutate(Chromosome &chromosome);
+    // also adds offspring of the parent (if given) into offspring_counts
     std::tuple<size_t, const Chromosome &>
-    get_best_chromosome(const Chromosome *const parent_ptr = nullptr);
+    get_best_chromosome(const Chromosome *const parent_ptr = nullptr,
+                        const size_t parent_fitness = 0);
+    // adapts mutation strength based on offspring_counts (if adaptive mutation
+    // used and enough offspring counted)
+    void adapt_mutation_strength(size_t generation);
+    // logs change of the mutation count (if any) together with the offspring
+    // counted since the last one, unless logged recently (or forced)
+    void log_mutation_count(size_t generation, bool force = false);
     void generate_default_population();
     void generate_new_population(const Chromosome &parent);
-    std::tuple<size_t, const Chromosome &> run_evolution(size_t iter_count);
-#ifndef STANDARD_VARIANT
+    // runs evolution, optionally starting from mutations of a given seed (or
+    // of a library solution) and stopping once a given target fitness is
+    // reached, solutions with maximal fitness are stored into the library
+    std::tuple<size_t, const Chromosome &>
+    run_evolution(size_t iter_count, const Chromosome *seed_ptr = nullptr,
+                  const size_t target_fitness = SIZE_MAX);
     // implements theorem 1 from http://msoeken.github.io/papers/2019_aspdac.pdf
+    // (XMG function set only, does nothing for other function sets)
     void theorem1(Chromosome chromosome, size_t blk_dx);
-#endif // STANDARD_VARIANT
+
+    // Decomposition
+
+    // splits outputs into groups of (first output, output count, row count)
+    std::vector<std::tuple<size_t, size_t, size_t>>
+    get_decomposition(size_t group_size);
+    // evolves groups of outputs in parallel on separate bands of rows, merges
+    // them into a single grid and finishes with a joint evolution within the
+    // remaining iterations
+    std::tuple<size_t, const Chromosome &>
+    run_decomposed_evolution(size_t iter_count, size_t group_size = 1);
 };
 
+// returns whether genes of a given type can index all nodes of a given grid
+template <typename Gene> constexpr bool fits_gene(const CGPConfig &config) {
+    return config.in_count + config.cols * config.rows - 1 <=
+           std::numeric_limits<Gene>::max();
+}
+
+// calls a given function with CGP using the smallest gene type able to index
+// all nodes of the grid given by the config
+template <typename FunctionSet, typename Function>
+void with_packed_cgp(const CGPConfig &config, std::ostream &out,
+                     Function function) {
+    if (fits_gene<uint8_t>(config)) {
+        CGP<FunctionSet, uint8_t> cgp(config, out);
+        function(cgp);
+    } else if (fits_gene<uint16_t>(config)) {
+        CGP<FunctionSet, uint16_t> cgp(config, out);
+        function(cgp);
+    } else {
+        CGP<FunctionSet, uint32_t> cgp(config, out);
+        function(cgp);
+    }
+}
+
+extern template struct CGP<XmgFunctionSet, uint8_t>;
+extern template struct CGP<XmgFunctionSet, uint16_t>;
+extern template struct CGP<XmgFunctionSet, uint32_t>;
+extern template struct CGP<StandardFunctionSet, uint8_t>;
+extern template struct CGP<StandardFunctionSet, uint16_t>;
+extern template struct CGP<StandardFunctionSet, uint32_t>;
+extern template struct CGP<AigFunctionSet, uint8_t>;
+extern template struct CGP<AigFunctionSet, uint16_t>;
+extern template struct CGP<AigFunctionSet, uint32_t>;
+extern template struct CGP<MigFunctionSet, uint8_t>;
+extern template struct CGP<MigFunctionSet, uint16_t>;
+extern template struct CGP<MigFunctionSet, uint32_t>;
+
 #endif // CGP_HPP
@@ -18,7 +18,7 @@ const std::vector<std::vector<Bitmap>> ADDER_2b_EXPECTED_OUTS{
     {0b0000000100110111U}, // out 2
 };
 const size_t ADDER_2b_ITERATION_COUNT = 2e5;
-const CGP ADDER_2b(4, ADDER_2b_EXPECTED_OUTS, 8, 8, 5, 10, 10);
+const CGPConfig ADDER_2b{4, ADDER_2b_EXPECTED_OUTS, 8, 8, 5, 10, 10};
 
 // Median with 7 inputs
 
@@ -28,7 +28,7 @@ const std::vector<std::vector<Bitmap>> MEDIAN_7_EXPECTED_OUTS{
      0b0000000100010111000101110111111100010111011111110111111111111111},
 };
 const size_t MEDIAN_7_ITERATION_COUNT = 1e5;
-const CGP MEDIAN_7(7, MEDIAN_7_EXPECTED_OUTS, 4, 4, 2, 10, 5);
+const CGPConfig MEDIAN_7{7, MEDIAN_7_EXPECTED_OUTS, 4, 4, 2, 10, 5};
 
 // Parity with 5 inputs
 
@@ -36,7 +36,7 @@ const std::vector<std::vector<Bitmap>> PARITY_5_EXPECTED_OUTS{
     {0b01101001100101101001011001101001}, // out 0
 };
 const size_t PARITY_5_ITERATION_COUNT = 2e4;
-const CGP PARITY_5(5, PARITY_5_EXPECTED_OUTS, 3, 2, 1, 5, 4);
+const CGPConfig PARITY_5{5, PARITY_5_EXPECTED_OUTS, 3, 2, 1, 5, 4};
 
 // Multiplier with 2b inputs
 
@@ -47,6 +47,6 @@ const std::vector<std::vector<Bitmap>> MULT_2b_EXPECTED_OUTS{
     {0b0000000000000001}, // out 3
 };
 const size_t MULT_2b_ITERATION_COUNT = 4e5;
-const CGP MULT_2b(6, MULT_2b_EXPECTED_OUTS, 7, 6, 3, 10, 10);
+const CGPConfig MULT_2b{6, MULT_2b_EXPECTED_OUTS, 7, 6, 3, 10, 10};
 
 #endif // EXAMPLES_HPP
@@ -0,0 +1,337 @@
+/**
+ * Project: BIN project
+ * Author: Tomáš Kučma
+ * Year: 2022/2023
+ * Description: Contains implementation of library of solved chromosomes used
+ *  for seeding the initial population of CGP
+ */
+
+#include "library.hpp"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <sstream>
+
+template <typename T> void hash_combine(size_t &hash, const T &value) {
+    hash ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15U + (hash << 6) +
+            (hash >> 2);
+}
+
+// whether the entries are for the same function set and grid
+bool is_same_grid(const LibraryEntry &entry, const LibraryEntry &other) {
+    return entry.function_set == other.function_set &&
+           entry.in_count == other.in_count && entry.cols == other.cols &&
+           entry.rows == other.rows && entry.l_back == other.l_back;
+}
+
+Library::Library(const std::string &path) : path{path} {
+    std::ifstream in(path);
+    std::string line;
+    for (size_t line_number = 1; std::getline(in, line); line_number++) {
+        std::istringstream line_in(line);
+        LibraryEntry entry;
+        if (!read_entry(line_in, entry)) {
+            std::cerr << "Skipping invalid library entry " << path << ":"
+                      << line_number << "\n";
+            continue;
+        }
+        entries.push_back(entry);
+        index_entry(entries.size() - 1);
+    }
+}
+
+std::optional<std::vector<Gene>>
+Library::find(const std::string &function_set, const CGPConfig &config,
+              const std::vector<std::vector<Bitmap>> &ins) {
+    LibraryEntry query{function_set, config.in_count, config.cols,
+                       config.rows,  config.l_back,   0,
+                       config.expected_outs};
+
+    // exact match of the expected outputs
+    const LibraryEntry *best_entry = nullptr;
+    {
+        std::lock_guard lock(mutex);
+        auto [first, last] = exact_index.equal_range(get_exact_hash(query));
+        for (auto iter = first; iter != last; iter++) {
+            const auto &entry = entries[iter->second];
+            if (is_same_grid(entry, query) &&
+                entry.expected_outs == query.expected_outs &&
+                (!best_entry || entry.fitness > best_entry->fitness)) {
+                best_entry = &entry;
+            }
+        }
+        if (best_entry) {
+            return best_entry->chromosome;
+        }
+    }
+
+    // match of the NPN class, whose (slow) computation depends only on the
+    // query, so it doesn't hold the lock
+    query.npn = get_npn_form(query.expected_outs, ins);
+    if (!query.npn) {
+        return std::nullopt;
+    }
+    std::lock_guard lock(mutex);
+    // canonical input i is input permutation[i] of both the entry and the
+    // query, so the entry's inputs can be rewired to the query's ones, as long
+    // as no negations are needed, i.e. canonical input i is negated the same
+    // way in both and so is the output
+    auto is_rewirable = [](const NpnTransform &entry,
+                           const NpnTransform &query, size_t in_count) {
+        if (entry.output_negation != query.output_negation) {
+            return false;
+        }
+        for (size_t i = 0; i < in_count; i++) {
+            if (((entry.input_negation >> entry.permutation[i]) & 1) !=
+                ((query.input_negation >> query.permutation[i]) & 1)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    const NpnTransform *best_transform = nullptr;
+    auto [first, last] = npn_index.equal_range(get_npn_hash(query));
+    for (auto iter = first; iter != last; iter++) {
+        const auto &entry = entries[iter->second];
+        if (!is_same_grid(entry, query) || !entry.npn ||
+            entry.npn->table != query.npn->table ||
+            (best_entry && entry.fitness <= best_entry->fitness)) {
+            continue;
+        }
+        // the query may reach the canonical form by several transforms
+        for (const auto &transform : query.npn->transforms) {
+            if (is_rewirable(entry.npn->transforms.front(), transform,
+                             query.in_count)) {
+                best_entry = &entry;
+                best_transform = &transform;
+                break;
+            }
+        }
+    }
+    if (!best_entry) {
+        return std::nullopt;
+    }
+
+    std::vector<Gene> input_map(query.in_count);
+    for (size_t i = 0; i < query.in_count; i++) {
+        input_map[best_entry->npn->transforms.front().permutation[i]] =
+            best_transform->permutation[i];
+    }
+    std::vector<Gene> chromosome = best_entry->chromosome;
+    const size_t out_count = query.expected_outs.size();
+    const size_t block_count = query.cols * query.rows;
+    const size_t block_size = (chromosome.size() - out_count) / block_count;
+    for (size_t i = 0; i < chromosome.size(); i++) {
+        const bool is_function =
+            i < block_count * block_size && i % block_size == block_size - 1;
+        if (!is_function && chromosome[i] < query.in_count) {
+            chromosome[i] = input_map[chromosome[i]];
+        }
+    }
+    return chromosome;
+}
+
+void Library::add(const std::string &function_set, const CGPConfig &config,
+                  const std::vector<std::vector<Bitmap>> &ins, size_t fitness,
+                  const std::vector<Gene> &chromosome) {
+    LibraryEntry entry{function_set,
+                       config.in_count,
+                       config.cols,
+                       config.rows,
+                       config.l_back,
+                       fitness,
+                       config.expected_outs,
+                       get_npn_form(config.expected_outs, ins),
+                       chromosome};
+    if (entry.npn) {
+        entry.npn->transforms.resize(1);
+    }
+
+    std::lock_guard lock(mutex);
+    auto [first, last] = exact_index.equal_range(get_exact_hash(entry));
+    for (auto iter = first; iter != last; iter++) {
+        const auto &other = entries[iter->second];
+        if (is_same_grid(other, entry) &&
+            other.expected_outs == entry.expected_outs &&
+            other.fitness >= entry.fitness) {
+            return;
+        }
+    }
+
+    entries.push_back(entry);
+    index_entry(entries.size() - 1);
+    std::ofstream out(path, std::ios::app);
+    write_entry(out, entry) << "\n";
+}
+
+size_t Library::get_exact_hash(const LibraryEntry &entry) {
+    size_t hash = 0;
+    hash_combine(hash, entry.function_set);
+    hash_combine(hash, entry.in_count);
+    hash_combine(hash, entry.cols);
+    hash_combine(hash, entry.rows);
+    hash_combine(hash, entry.l_back);
+    for (const auto &out : entry.expected_outs) {
+        for (const auto &word : out) {
+            hash_combine(hash, word);
+        }
+    }
+    return hash;
+}
+
+size_t Library::get_npn_hash(const LibraryEntry &entry) {
+    size_t hash = 0;
+    hash_combine(hash, entry.function_set);
+    hash_combine(hash, entry.in_count);
+    hash_combine(hash, entry.cols);
+    hash_combine(hash, entry.rows);
+    hash_combine(hash, entry.l_back);
+    hash_combine(hash, entry.npn->table);
+    return hash;
+}
+
+void Library::index_entry(size_t entry_index) {
+    const auto &entry = entries[entry_index];
+    exact_index.emplace(get_exact_hash(entry), entry_index);
+    if (entry.npn) {
+        npn_index.emplace(get_npn_hash(entry), entry_index);
+    }
+}
+
+std::optional<NpnForm>
+Library::get_npn_form(const std::vector<std::vector<Bitmap>> &expected_outs,
+                      const std::vector<std::vector<Bitmap>> &ins) {
+    const size_t in_count = ins.size();
+    if (expected_outs.size() != 1 || in_count > NPN_MAX_IN_COUNT) {
+        return std::nullopt;
+    }
+    const size_t bit_count = 1UL << in_count;
+    const Bitmap mask =
+        bit_count < BITMAP_SIZE ? (1UL << bit_count) - 1 : ~0UL;
+    const Bitmap table = expected_outs[0][0] & mask;
+
+    // values of the inputs for each bit of the truth table and vice versa
+    std::array<size_t, BITMAP_SIZE> in_values{};
+    std::array<size_t, BITMAP_SIZE> bit_indexes{};
+    for (size_t bit = 0; bit < bit_count; bit++) {
+        for (size_t i = 0; i < in_count; i++) {
+            in_values[bit] |= ((ins[i][0] >> bit) & 1) << i;
+        }
+        bit_indexes[in_values[bit]] = bit;
+    }
+
+    NpnForm best{~0UL, {}};
+    NpnTransform transform{};
+    std::iota(transform.permutation.begin(),
+              transform.permutation.begin() + in_count, 0);
+    do {
+        std::array<size_t, BITMAP_SIZE> permuted_values{};
+        for (size_t bit = 0; bit < bit_count; bit++) {
+            for (size_t i = 0; i < in_count; i++) {
+                permuted_values[bit] |= ((in_values[bit] >> i) & 1)
+                                        << transform.permutation[i];
+            }
+        }
+        // all 2^in_count combinations of negated inputs
+        for (size_t negation = 0; negation < bit_count; negation++) {
+            Bitmap permuted = 0;
+            for (size_t bit = 0; bit < bit_count; bit++) {
+                const size_t source =
+                    bit_indexes[permuted_values[bit] ^ negation];
+                permuted |= ((table >> source) & 1) << bit;
+            }
+            transform.input_negation = negation;
+            // with or without negated output
+            for (const bool output_negation : {false, true}) {
+                const Bitmap candidate =
+                    output_negation ? ~permuted & mask : permuted;
+                transform.output_negation = output_negation;
+                if (candidate < best.table) {
+                    best = {candidate, {transform}};
+                } else if (candidate == best.table) {
+                    best.transforms.push_back(transform);
+                }
+            }
+        }
+    } while (std::next_permutation(transform.permutation.begin(),
+                                   transform.permutation.begin() + in_count));
+    return best;
+}
+
+std::istream &Library::read_entry(std::istream &in, LibraryEntry &entry) {
+    size_t out_count;
+    in >> entry.function_set >> entry.in_count >> entry.cols >> entry.rows >>
+        entry.l_back >> entry.fitness >> out_count;
+    if (!in || entry.in_count >= BITMAP_SIZE) {
+        in.setstate(std::ios::failbit);
+        return in;
+    }
+    // values are appended one by one, so that damaged counts can't allocate
+    // more than the entry actually holds
+    const size_t bitmap_count =
+        std::max((1UL << entry.in_count) / BITMAP_SIZE, 1UL);
+    entry.expected_outs.clear();
+    in >> std::hex;
+    for (size_t j = 0; j < out_count && in; j++) {
+        auto &out = entry.expected_outs.emplace_back();
+        Bitmap word;
+        for (size_t i = 0; i < bitmap_count && in >> word; i++) {
+            out.push_back(word);
+        }
+    }
+    bool has_npn;
+    in >> has_npn;
+    entry.npn.reset();
+    if (has_npn) {
+        NpnTransform transform{};
+        Bitmap table;
+        in >> table >> std::dec;
+        for (size_t i = 0; i < entry.in_count; i++) {
+            size_t input;
+            in >> input;
+            if (input >= entry.in_count || entry.in_count > NPN_MAX_IN_COUNT) {
+                in.setstate(std::ios::failbit);
+                return in;
+            }
+            transform.permutation[i] = input;
+        }
+        in >> transform.input_negation >> transform.output_negation;
+        entry.npn = NpnForm{table, {transform}};
+    }
+    size_t gene_count;
+    in >> std::dec >> gene_count;
+    entry.chromosome.clear();
+    Gene gene;
+    for (size_t i = 0; i < gene_count && in >> gene; i++) {
+        entry.chromosome.push_back(gene);
+    }
+    return in;
+}
+
+std::ostream &Library::write_entry(std::ostream &out,
+                                   const LibraryEntry &entry) {
+    out << entry.function_set << " " << entry.in_count << " " << entry.cols
+        << " " << entry.rows << " " << entry.l_back << " " << entry.fitness
+        << " " << entry.expected_outs.size() << std::hex;
+    for (const auto &expected_out : entry.expected_outs) {
+        for (const auto &word : expected_out) {
+            out << " " << word;
+        }
+    }
+    out << " " << entry.npn.has_value();
+    if (entry.npn) {
+        const auto &transform = entry.npn->transforms.front();
+        out << " " << entry.npn->table << std::dec;
+        for (size_t i = 0; i < entry.in_count; i++) {
+            out << " " << +transform.permutation[i];
+        }
+        out << " " << transform.input_negation << " "
+            << transform.output_negation;
+    }
+    out << std::dec << " " << entry.chromosome.size();
+    for (const auto &gene : entry.chromosome) {
+        out << " " << gene;
+    }
+    return out;
+}
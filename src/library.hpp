@@ -0,0 +1,91 @@
+/**
+ * Project: BIN project
+ * Author: Tomáš Kučma
+ * Year: 2022/2023
+ * Description: Contains definition of library of solved chromosomes used for
+ *  seeding the initial population of CGP
+ */
+
+#ifndef LIBRARY_HPP
+#define LIBRARY_HPP
+
+#include "cgp.hpp"
+#include "types.hpp"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// maximal input count of single output circuits looked up by NPN class
+constexpr size_t NPN_MAX_IN_COUNT = 6;
+
+// transform of a single output truth table into its NPN canonical form,
+// canonical input i is input permutation[i], negated if bit permutation[i] of
+// input_negation is set, and the output is negated if output_negation is set
+struct NpnTransform {
+    std::array<uint8_t, NPN_MAX_IN_COUNT> permutation;
+    size_t input_negation;
+    bool output_negation;
+};
+
+// NPN canonical form of a single output truth table together with the
+// transforms giving it (library entries keep only the first one)
+struct NpnForm {
+    Bitmap table;
+    std::vector<NpnTransform> transforms;
+};
+
+// solved chromosome stored in the library
+struct LibraryEntry {
+    std::string function_set;
+    size_t in_count;
+    size_t cols;
+    size_t rows;
+    size_t l_back;
+    size_t fitness;
+    std::vector<std::vector<Bitmap>> expected_outs;
+    std::optional<NpnForm> npn;
+    std::vector<Gene> chromosome;
+};
+
+// library of solved chromosomes indexed by function set, grid shape and
+// expected outputs (or their NPN class for small single output circuits),
+// stored in a text file with one entry per line, safe to use from multiple
+// threads
+struct Library {
+    const std::string path;
+    std::vector<LibraryEntry> entries;
+    std::unordered_multimap<size_t, size_t> exact_index;
+    std::unordered_multimap<size_t, size_t> npn_index;
+    std::mutex mutex;
+
+    Library(const std::string &path);
+
+    // returns chromosome of the best entry solving expected outputs of the
+    // config on the same grid, or (with inputs rewired) of the best entry of
+    // the same NPN class which can be turned into the solution without
+    // negating any of its inputs or its output
+    std::optional<std::vector<Gene>>
+    find(const std::string &function_set, const CGPConfig &config,
+         const std::vector<std::vector<Bitmap>> &ins);
+    // adds a solved chromosome, unless the library already has a solution at
+    // least as good
+    void add(const std::string &function_set, const CGPConfig &config,
+             const std::vector<std::vector<Bitmap>> &ins, size_t fitness,
+             const std::vector<Gene> &chromosome);
+
+    size_t get_exact_hash(const LibraryEntry &entry);
+    size_t get_npn_hash(const LibraryEntry &entry);
+    void index_entry(size_t entry_index);
+    std::optional<NpnForm>
+    get_npn_form(const std::vector<std::vector<Bitmap>> &expected_outs,
+                 const std::vector<std::vector<Bitmap>> &ins);
+    std::istream &read_entry(std::istream &in, LibraryEntry &entry);
+    std::ostream &write_entry(std::ostream &out, const LibraryEntry &entry);
+};
+
+#endif // LIBRARY_HPP
@@ -6,70 +6,288 @@
  */
 
 #include "examples.hpp"
+#include "library.hpp"
+#include "racing.hpp"
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
-#ifdef STANDARD_VARIANT
-constexpr const char *out_folder = "logs_standard/";
-#else  // STANDARD_VARIANT
-constexpr const char *out_folder = "logs/";
-#endif // STANDARD_VARIANT
-
-void test_cgp(CGP cgp, const size_t iteration_count) {
-    auto best = cgp.run_evolution(iteration_count);
-    auto best_chromosome = std::get<const Chromosome &>(best);
-    auto best_fitness = std::get<size_t>(best);
-    std::cout << "Best chromosome:\n";             // DEBUG
-    cgp.print_chromosome(best_chromosome) << "\n"; // DEBUG
-    std::cout << "Best fitness ";                  // DEBUG
-    cgp.print_fitness(best_fitness) << "\n\n\n";   // DEBUG
+// options given on the command line
+struct Options {
+    // size of output groups evolved separately (0 disables decomposition)
+    size_t decomposition_group_size = 0;
+    bool adaptive_mutation = false;
+    // whether to race configurations when generating statistics
+    bool racing = false;
+    // library of solutions used for seeding evolution (if any)
+    Library *library = nullptr;
+    // seed from which the seeds of all runs are derived
+    unsigned seed = time(NULL);
+};
+
+// returns seed of a run identified by its name, so that each run is
+// reproducible regardless of the order and the threads the runs are run in
+unsigned get_run_seed(const Options &options, const std::string &run_name) {
+    std::seed_seq seed_seq{options.seed,
+                           unsigned(std::hash<std::string>{}(run_name))};
+    unsigned seed;
+    seed_seq.generate(&seed, &seed + 1);
+    return seed;
+}
+
+// returns folder for the logs of a given function set
+template <typename FunctionSet> std::string out_folder() {
+    if constexpr (std::is_same_v<FunctionSet, XmgFunctionSet>) {
+        return "logs/";
+    } else {
+        return std::string{"logs_"} + FunctionSet::name + "/";
+    }
 }
 
-void test_cgp_configurations(const CGP &cgp, const size_t iteration_count,
-                             std::string file_prefix) {
+template <typename FunctionSet>
+void test_cgp(const CGPConfig &config, const size_t iteration_count,
+              const Options &options, const std::string &name,
+              std::ostream &out) {
+    CGPConfig cgp_config{config};
+    cgp_config.adaptive_mutation = options.adaptive_mutation;
+    with_packed_cgp<FunctionSet>(cgp_config, out, [&](auto &cgp) {
+        cgp.library = options.library;
+        cgp.random_engine.seed(
+            get_run_seed(options, std::string{FunctionSet::name} + "/" + name));
+        auto best = options.decomposition_group_size
+                        ? cgp.run_decomposed_evolution(
+                              iteration_count, options.decomposition_group_size)
+                        : cgp.run_evolution(iteration_count);
+        auto [best_fitness, best_chromosome] = best;
+        out << "Best chromosome:\n";                   // DEBUG
+        cgp.print_chromosome(best_chromosome) << "\n"; // DEBUG
+        out << "Best fitness ";                        // DEBUG
+        cgp.print_fitness(best_fitness) << "\n\n\n";   // DEBUG
+    });
+}
+
+template <typename FunctionSet>
+void test_cgp_configurations(const CGPConfig &config,
+                             const size_t iteration_count,
+                             const Options &options, std::string file_prefix,
+                             std::ostream &out) {
     constexpr size_t experiment_count = 10;
+    std::filesystem::create_directories(out_folder<FunctionSet>());
+    std::vector<size_t> pop_sizes;
     for (size_t pop_size = 5; pop_size <= 20; pop_size += 5) {
+        pop_sizes.push_back(pop_size);
+    }
+
+    // runs i-th experiment with given population size, logging into a file
+    auto run_experiment = [&](size_t pop_size, size_t i) {
+        const std::string run_name = file_prefix + "_" +
+                                     std::to_string(pop_size) + "_" +
+                                     std::to_string(i);
+        std::ofstream log(out_folder<FunctionSet>() + "/" + run_name + ".log");
+        CGPConfig pop_config{config};
+        pop_config.lambda = pop_size - 1;
+        pop_config.adaptive_mutation = options.adaptive_mutation;
+        const size_t config_iteration_count =
+            (config.lambda + 1) * iteration_count / pop_size;
+        RunResult result{};
+        with_packed_cgp<FunctionSet>(pop_config, log, [&](auto &cgp) {
+            // solutions are only stored, as seeding from the library (shared
+            // by all population sizes) would make the runs start solved
+            cgp.library = options.library;
+            cgp.library_seeding = false;
+            cgp.random_engine.seed(get_run_seed(
+                options, std::string{FunctionSet::name} + "/" + run_name));
+            auto best = options.decomposition_group_size
+                            ? cgp.run_decomposed_evolution(
+                                  config_iteration_count,
+                                  options.decomposition_group_size)
+                            : cgp.run_evolution(config_iteration_count);
+            result = {std::get<size_t>(best),
+                      cgp.solution_generation * (cgp.lambda + 1)};
+        });
+        return result;
+    };
+
+    if (options.racing) {
+        std::vector<std::string> names;
+        for (const auto &pop_size : pop_sizes) {
+            names.push_back(file_prefix + "_" + std::to_string(pop_size));
+        }
+        race_configurations(
+            names, experiment_count,
+            [&](size_t candidate, size_t i) {
+                return run_experiment(pop_sizes[candidate], i);
+            },
+            out);
+        return;
+    }
+    for (const auto &pop_size : pop_sizes) {
         for (size_t i = 0; i < experiment_count; i++) {
-            std::ofstream out(std::string{out_folder} + "/" + file_prefix +
-                              "_" + std::to_string(pop_size) + "_" +
-                              std::to_string(i) + ".log");
-            CGP config_cgp(cgp.in_count, cgp.expected_outs, cgp.cols, cgp.rows,
-                           cgp.l_back, pop_size - 1, cgp.mutation_max_count,
-                           out);
-            config_cgp.run_evolution((cgp.lambda + 1) * iteration_count /
-                                     pop_size);
+            run_experiment(pop_size, i);
         }
     }
 }
 
-void run_statistics() {
-    std::cout << "Generating statistics\n\n";
-    std::cout << "2bit adder\n";
-    test_cgp_configurations(ADDER_2b, ADDER_2b_ITERATION_COUNT, "adder2b");
-    std::cout << "7 input median\n";
-    test_cgp_configurations(MEDIAN_7, MEDIAN_7_ITERATION_COUNT, "median7");
-    std::cout << "5 input parity\n";
-    test_cgp_configurations(PARITY_5, PARITY_5_ITERATION_COUNT, "parity5");
-    std::cout << "2bit input multiplier\n";
-    test_cgp_configurations(MULT_2b, MULT_2b_ITERATION_COUNT, "mult2b");
+template <typename FunctionSet>
+void run_statistics(const Options &options, std::ostream &out) {
+    out << "Generating statistics\n\n";
+    out << "2bit adder\n";
+    test_cgp_configurations<FunctionSet>(ADDER_2b, ADDER_2b_ITERATION_COUNT,
+                                         options, "adder2b", out);
+    out << "7 input median\n";
+    test_cgp_configurations<FunctionSet>(MEDIAN_7, MEDIAN_7_ITERATION_COUNT,
+                                         options, "median7", out);
+    out << "5 input parity\n";
+    test_cgp_configurations<FunctionSet>(PARITY_5, PARITY_5_ITERATION_COUNT,
+                                         options, "parity5", out);
+    out << "2bit input multiplier\n";
+    test_cgp_configurations<FunctionSet>(MULT_2b, MULT_2b_ITERATION_COUNT,
+                                         options, "mult2b", out);
 }
 
-void run_examples() {
-    std::cout << "Running with examples\n\n";
-    std::cout << "CGP for 2bit adder:\n\n";
-    test_cgp(ADDER_2b, ADDER_2b_ITERATION_COUNT);
-    std::cout << "CGP for 7 input median:\n\n";
-    test_cgp(MEDIAN_7, MEDIAN_7_ITERATION_COUNT);
-    std::cout << "CGP for 5 input parity:\n\n";
-    test_cgp(PARITY_5, PARITY_5_ITERATION_COUNT);
-    std::cout << "CGP for 2bit input multiplier:\n\n";
-    test_cgp(MULT_2b, MULT_2b_ITERATION_COUNT);
+template <typename FunctionSet>
+void run_examples(const Options &options, std::ostream &out) {
+    out << "Running with examples\n\n";
+    out << "CGP for 2bit adder:\n\n";
+    test_cgp<FunctionSet>(ADDER_2b, ADDER_2b_ITERATION_COUNT, options,
+                          "adder2b", out);
+    out << "CGP for 7 input median:\n\n";
+    test_cgp<FunctionSet>(MEDIAN_7, MEDIAN_7_ITERATION_COUNT, options,
+                          "median7", out);
+    out << "CGP for 5 input parity:\n\n";
+    test_cgp<FunctionSet>(PARITY_5, PARITY_5_ITERATION_COUNT, options,
+                          "parity5", out);
+    out << "CGP for 2bit input multiplier:\n\n";
+    test_cgp<FunctionSet>(MULT_2b, MULT_2b_ITERATION_COUNT, options,
+                          "mult2b", out);
+}
+
+template <typename FunctionSet>
+void run_function_set(const Options &options, std::ostream &out) {
+    out << "Function set: " << FunctionSet::name << "\n\n";
+    run_examples<FunctionSet>(options, out);
+    out << std::string(80, '-') << "\n";
+    run_statistics<FunctionSet>(options, out);
+}
+
+// function sets selectable from the command line, each one is instantiated
+// separately, so the choice is made only once here
+const std::map<std::string, void (*)(const Options &, std::ostream &)>
+    FUNCTION_SETS{
+        {XmgFunctionSet::name, run_function_set<XmgFunctionSet>},
+        {StandardFunctionSet::name, run_function_set<StandardFunctionSet>},
+        {AigFunctionSet::name, run_function_set<AigFunctionSet>},
+        {MigFunctionSet::name, run_function_set<MigFunctionSet>},
+    };
+
+void print_usage(const char *program) {
+    std::cerr << "Usage: " << program
+              << " [-a] [-r] [-d GROUP_SIZE] [-l LIBRARY] [-s SEED] "
+                 "[all | FUNCTION_SET...]\n"
+              << "  -a             adapt mutation count during evolution\n"
+              << "  -r             race configurations, eliminating the "
+                 "significantly worse ones early\n"
+              << "  -d GROUP_SIZE  evolve groups of GROUP_SIZE outputs in "
+                 "parallel first\n"
+              << "  -l LIBRARY     seed evolution from and store solutions "
+                 "into LIBRARY file (statistics only store them)\n"
+              << "  -s SEED        seed of the random engines (current time "
+                 "by default)\n"
+              << "Function sets:";
+    for (const auto &[name, run] : FUNCTION_SETS) {
+        std::cerr << " " << name;
+    }
+    std::cerr << " (default " << XmgFunctionSet::name << ")\n";
 }
 
 int main(int argc, char *argv[]) {
-    srand(time(NULL));
-    run_examples();
-    std::cout << std::string(80, '-') << "\n";
-    run_statistics();
+    Options options;
+    std::unique_ptr<Library> library;
+    std::vector<std::string> names;
+    try {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg{argv[i]};
+            if (arg == "-a") {
+                options.adaptive_mutation = true;
+            } else if (arg == "-r") {
+                options.racing = true;
+            } else if (arg == "-d" && i + 1 < argc) {
+                options.decomposition_group_size = std::stoul(argv[++i]);
+            } else if (arg == "-l" && i + 1 < argc) {
+                library = std::make_unique<Library>(argv[++i]);
+                options.library = library.get();
+            } else if (arg == "-s" && i + 1 < argc) {
+                const unsigned long seed = std::stoul(argv[++i]);
+                if (seed > std::numeric_limits<unsigned>::max()) {
+                    throw std::out_of_range("Seed out of range");
+                }
+                options.seed = seed;
+            } else if (arg == "-d" || arg == "-l" || arg == "-s") {
+                print_usage(argv[0]);
+                return 1;
+            } else {
+                names.push_back(arg);
+            }
+        }
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (names.empty()) {
+        names.push_back(XmgFunctionSet::name);
+    } else if (names.size() == 1 && names[0] == "all") {
+        names.clear();
+        for (const auto &[name, run] : FUNCTION_SETS) {
+            names.push_back(name);
+        }
+    }
+    for (const auto &name : names) {
+        if (!FUNCTION_SETS.contains(name)) {
+            std::cerr << "Unknown function set " << name << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    // each function set is run once, as its runs share the log files
+    for (auto iter = names.begin(); iter != names.end(); iter++) {
+        names.erase(std::remove(iter + 1, names.end(), *iter), names.end());
+    }
+
+    std::cout << "Seed: " << options.seed << "\n\n";
+    if (names.size() == 1) {
+        FUNCTION_SETS.at(names[0])(options, std::cout);
+        return 0;
+    }
+
+    // run multiple function sets concurrently, the output of each is printed
+    // as a whole once it's finished
+    std::mutex out_mutex;
+    std::vector<std::thread> threads;
+    for (const auto &name : names) {
+        threads.emplace_back([&name, &options, &out_mutex]() {
+            std::ostringstream out;
+            FUNCTION_SETS.at(name)(options, out);
+            std::lock_guard lock(out_mutex);
+            std::cout << out.str() << std::string(80, '=') << "\n";
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
     return 0;
 }
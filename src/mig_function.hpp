@@ -0,0 +1,74 @@
+/**
+ * Project: BIN project
+ * Author: Tomáš Kučma
+ * Year: 2022/2023
+ * Description: Contains definition of types and declaration of functions used
+ *  for function blocks [Majority-Inverter Graph variant]
+ */
+
+#ifndef MIG_FUNCTION_HPP
+#define MIG_FUNCTION_HPP
+
+#include "function.hpp"
+#include "types.hpp"
+#include <array>
+
+// Function set of Majority blocks with optionally inverted inputs (MIG),
+// including the majority blocks with a constant input (AND and OR)
+struct MigFunctionSet {
+    static constexpr const char *name = "mig";
+    static constexpr size_t BLOCK_IN_COUNT = 3;
+    static constexpr size_t COST = 1;
+    static constexpr size_t MAX_BLOCK_COST = COST;
+
+    using BlockInput = std::array<Bitmap, BLOCK_IN_COUNT>;
+
+    enum Function {
+        MAJ_000,
+        MAJ_001,
+        MAJ_011,
+        MAJ_111,
+        MAJ_AND, // majority with constant 0 input
+        MAJ_OR,  // majority with constant 1 input
+        FUNCTION_COUNT,
+    };
+
+    static constexpr bool is_const_maj(const Function &function) {
+        return MAJ_AND <= function && function <= MAJ_OR;
+    }
+
+    static constexpr size_t function_in_count(const Function &function) {
+        return is_const_maj(function) ? 2 : 3;
+    }
+
+    // returns cost assigned to a given function block
+    static constexpr size_t function_cost(const Function &function) {
+        return COST;
+    }
+
+    static constexpr Bitmap simulate_function(const BlockInput &inputs,
+                                              const Function &function) {
+        switch (function) {
+        case MAJ_000:
+            return (~inputs[0] & ~inputs[1]) | (~inputs[0] & ~inputs[2]) |
+                   (~inputs[1] & ~inputs[2]);
+        case MAJ_001:
+            return (~inputs[0] & ~inputs[1]) | (~inputs[0] & inputs[2]) |
+                   (~inputs[1] & inputs[2]);
+        case MAJ_011:
+            return (~inputs[0] & inputs[1]) | (~inputs[0] & inputs[2]) |
+                   (inputs[1] & inputs[2]);
+        case MAJ_111:
+            return (inputs[0] & inputs[1]) | (inputs[0] & inputs[2]) |
+                   (inputs[1] & inputs[2]);
+        case MAJ_AND:
+            return inputs[0] & inputs[1];
+        case MAJ_OR:
+            return inputs[0] | inputs[1];
+        default:
+            throw FunctionError(function);
+        }
+    }
+};
+
+#endif // MIG_FUNCTION_HPP
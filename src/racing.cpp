@@ -0,0 +1,183 @@
+/**
+ * Project: BIN project
+ * Author: Tomáš Kučma
+ * Year: 2022/2023
+ * Description: Contains implementation of statistical racing of CGP
+ *  configurations
+ */
+
+#include "racing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+// returns ranks (from 1, worst first) of the results of all given samples
+// pooled together, tied results get their average rank, also returns sum of
+// (t^3 - t) over all groups of t tied results
+static std::tuple<std::vector<std::vector<double>>, double>
+get_pooled_ranks(const std::vector<const std::vector<RunResult> *> &samples) {
+    std::vector<std::tuple<RunResult, size_t, size_t>> pooled;
+    std::vector<std::vector<double>> ranks;
+    for (size_t s = 0; s < samples.size(); s++) {
+        ranks.emplace_back(samples[s]->size());
+        for (size_t i = 0; i < samples[s]->size(); i++) {
+            pooled.emplace_back((*samples[s])[i], s, i);
+        }
+    }
+    std::sort(pooled.begin(), pooled.end());
+
+    double tie_sum = 0;
+    for (size_t first = 0, last = 0; first < pooled.size(); first = last) {
+        while (last < pooled.size() &&
+               std::get<RunResult>(pooled[last]) ==
+                   std::get<RunResult>(pooled[first])) {
+            last++;
+        }
+        const double rank = (first + last + 1) / 2.0; // average of first..last
+        for (size_t j = first; j < last; j++) {
+            ranks[std::get<1>(pooled[j])][std::get<2>(pooled[j])] = rank;
+        }
+        const double tied = last - first;
+        tie_sum += tied * tied * tied - tied;
+    }
+    return {ranks, tie_sum};
+}
+
+// returns probability of the first n1 of given ranks having sum of ranks at
+// most a given one, when drawn at random from all the ranks (exact
+// distribution, valid with ties as well)
+static double get_exact_rank_sum_p(const std::vector<double> &ranks,
+                                   size_t n1, double rank_sum) {
+    // ranks of ties are averages, so doubled ranks are whole numbers
+    size_t max_sum = 0;
+    for (const auto &rank : ranks) {
+        max_sum += std::lround(2 * rank);
+    }
+    // counts[k][s] is amount of k ranks with doubled sum s chosen so far
+    std::vector<std::vector<double>> counts(
+        n1 + 1, std::vector<double>(max_sum + 1, 0));
+    counts[0][0] = 1;
+    for (size_t i = 0; i < ranks.size(); i++) {
+        const size_t doubled = std::lround(2 * ranks[i]);
+        for (size_t k = std::min(i + 1, n1); k > 0; k--) {
+            for (size_t sum = max_sum; sum >= doubled; sum--) {
+                counts[k][sum] += counts[k - 1][sum - doubled];
+            }
+        }
+    }
+    const size_t observed = std::lround(2 * rank_sum);
+    const double at_most = std::accumulate(
+        counts[n1].begin(), counts[n1].begin() + observed + 1, 0.0);
+    return at_most /
+           std::accumulate(counts[n1].begin(), counts[n1].end(), 0.0);
+}
+
+double mann_whitney_worse_p(const std::vector<RunResult> &results,
+                            const std::vector<RunResult> &other_results) {
+    const double n1 = results.size();
+    const double n2 = other_results.size();
+    const double n = n1 + n2;
+    if (!n1 || !n2) {
+        return 1;
+    }
+    auto [ranks, tie_sum] = get_pooled_ranks({&results, &other_results});
+
+    const double rank_sum =
+        std::accumulate(ranks[0].begin(), ranks[0].end(), 0.0);
+    if (n <= RACE_EXACT_MAX_COUNT) {
+        std::vector<double> pooled_ranks(ranks[0]);
+        pooled_ranks.insert(pooled_ranks.end(), ranks[1].begin(),
+                            ranks[1].end());
+        return get_exact_rank_sum_p(pooled_ranks, results.size(), rank_sum);
+    }
+    const double u = rank_sum - n1 * (n1 + 1) / 2;
+    const double variance =
+        n1 * n2 / 12 * ((n + 1) - tie_sum / (n * (n - 1)));
+    if (variance <= 0) { // all results tied
+        return 1;
+    }
+    const double z = (u - n1 * n2 / 2) / std::sqrt(variance);
+    return 0.5 * std::erfc(-z / std::sqrt(2.0));
+}
+
+std::vector<size_t>
+race_configurations(const std::vector<std::string> &names,
+                    size_t repeat_count,
+                    const std::function<RunResult(size_t, size_t)> &run,
+                    std::ostream &out) {
+    std::vector<std::vector<RunResult>> results(names.size());
+    std::vector<size_t> remaining(names.size());
+    std::iota(remaining.begin(), remaining.end(), 0);
+    size_t budget = names.size() * repeat_count;
+    // amount of rounds testing for elimination, the ones run only thanks to
+    // the budget of eliminated configurations just use it up
+    const size_t look_count = repeat_count > RACE_MIN_REPEAT_COUNT
+                                  ? repeat_count - RACE_MIN_REPEAT_COUNT + 1
+                                  : 1;
+
+    for (size_t round = 0; remaining.size() > 1 && budget >= remaining.size();
+         round++) {
+        for (const auto &candidate : remaining) {
+            results[candidate].push_back(
+                run(candidate, results[candidate].size()));
+        }
+        budget -= remaining.size();
+        if (round + 1 < RACE_MIN_REPEAT_COUNT ||
+            round + 1 >= RACE_MIN_REPEAT_COUNT + look_count) {
+            continue;
+        }
+
+        // the leader has the highest mean rank among the remaining results
+        std::vector<const std::vector<RunResult> *> samples;
+        for (const auto &candidate : remaining) {
+            samples.push_back(&results[candidate]);
+        }
+        auto [ranks, tie_sum] = get_pooled_ranks(samples);
+        size_t leader = 0;
+        double leader_rank = 0;
+        for (size_t i = 0; i < remaining.size(); i++) {
+            const double mean_rank =
+                std::accumulate(ranks[i].begin(), ranks[i].end(), 0.0) /
+                ranks[i].size();
+            if (mean_rank > leader_rank) {
+                leader = remaining[i];
+                leader_rank = mean_rank;
+            }
+        }
+
+        // Holm-Bonferroni method, the comparisons are tested from the lowest
+        // p-value with significance level divided by the amount of the ones
+        // not tested yet, stopping at the first one not significant
+        std::vector<std::tuple<double, size_t>> comparisons;
+        for (const auto &candidate : remaining) {
+            if (candidate != leader) {
+                comparisons.emplace_back(
+                    mann_whitney_worse_p(results[candidate], results[leader]),
+                    candidate);
+            }
+        }
+        std::sort(comparisons.begin(), comparisons.end());
+        for (size_t i = 0; i < comparisons.size(); i++) {
+            const auto &[p, candidate] = comparisons[i];
+            const double alpha =
+                RACE_ALPHA / look_count / (comparisons.size() - i);
+            if (p >= alpha) {
+                break;
+            }
+            out << "Round " << round + 1 << ": eliminated " << names[candidate]
+                << " (worse than " << names[leader] << ", p=" << p << " < "
+                << alpha << ")\n";
+            std::erase(remaining, candidate);
+        }
+    }
+
+    out << "Remaining:";
+    for (const auto &candidate : remaining) {
+        out << " " << names[candidate] << " (" << results[candidate].size()
+            << " repeats)";
+    }
+    out << "\n";
+    return remaining;
+}
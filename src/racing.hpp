@@ -0,0 +1,60 @@
+/**
+ * Project: BIN project
+ * Author: Tomáš Kučma
+ * Year: 2022/2023
+ * Description: Contains declaration of functions used for statistical racing
+ *  of CGP configurations
+ */
+
+#ifndef RACING_HPP
+#define RACING_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// minimal amount of repeats of each configuration before any is eliminated
+constexpr size_t RACE_MIN_REPEAT_COUNT = 5;
+// family-wise significance level for eliminating configurations, split evenly
+// between the rounds planned by the repeat count (from RACE_MIN_REPEAT_COUNT
+// on) and Holm adjusted over the comparisons with the leader in each of them
+constexpr double RACE_ALPHA = 0.05;
+// maximal amount of pooled results for which Mann-Whitney U test uses the
+// exact distribution instead of the normal approximation
+constexpr size_t RACE_EXACT_MAX_COUNT = 50;
+
+// result of a single run, better results have higher fitness or reach the
+// maximal fitness after less evaluations (of the whole run if never), which
+// unlike generations don't depend on the population size
+struct RunResult {
+    size_t fitness;
+    size_t evaluation_count;
+
+    bool operator==(const RunResult &other) const = default;
+    bool operator<(const RunResult &other) const {
+        return fitness < other.fitness ||
+               (fitness == other.fitness &&
+                evaluation_count > other.evaluation_count);
+    }
+};
+
+// returns one-sided p-value of Mann-Whitney U test for results being worse
+// than other results (exact permutation distribution of the ranks for up to
+// RACE_EXACT_MAX_COUNT results, otherwise normal approximation with correction
+// for ties)
+double mann_whitney_worse_p(const std::vector<RunResult> &results,
+                            const std::vector<RunResult> &other_results);
+
+// runs repeats of given configurations in rounds and eliminates the ones
+// significantly worse than the current leader (see RACE_ALPHA), the budget of
+// eliminated configurations is used for further repeats of the remaining ones,
+// returns indexes of the remaining configurations
+std::vector<size_t>
+race_configurations(const std::vector<std::string> &names,
+                    size_t repeat_count,
+                    const std::function<RunResult(size_t, size_t)> &run,
+                    std::ostream &out = std::cout);
+
+#endif // RACING_HPP
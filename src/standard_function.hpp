@@ -9,57 +9,57 @@
 #ifndef STANDARD_FUNCTION_HPP
 #define STANDARD_FUNCTION_HPP
 
+#include "function.hpp"
 #include "types.hpp"
 #include <array>
-#include <stdexcept>
-#include <string>
 
-constexpr size_t BLOCK_IN_COUNT = 2;
-constexpr size_t COST = 1;
-constexpr size_t MAX_BLOCK_COST = COST;
+// Function set of standard 2 input gates (AND, OR, XOR, NAND, NOR, NXOR)
+struct StandardFunctionSet {
+    static constexpr const char *name = "standard";
+    static constexpr size_t BLOCK_IN_COUNT = 2;
+    static constexpr size_t COST = 1;
+    static constexpr size_t MAX_BLOCK_COST = COST;
 
-using BlockInput = std::array<Bitmap, BLOCK_IN_COUNT>;
+    using BlockInput = std::array<Bitmap, BLOCK_IN_COUNT>;
 
-enum Function {
-    AND,
-    OR,
-    XOR,
-    NAND,
-    NOR,
-    NXOR,
-    FUNCTION_COUNT,
-};
-
-class FunctionError : public std::invalid_argument {
-  public:
-    FunctionError(const Function &function)
-        : std::invalid_argument(std::string{"Invalid function block "} +
-                                std::to_string(function)){};
-};
+    enum Function {
+        AND,
+        OR,
+        XOR,
+        NAND,
+        NOR,
+        NXOR,
+        FUNCTION_COUNT,
+    };
 
-constexpr size_t function_in_count(const Function &function) { return 2; }
+    static constexpr size_t function_in_count(const Function &function) {
+        return 2;
+    }
 
-// returns cost assigned to a given function block
-constexpr size_t function_cost(const Function &function) { return COST; }
+    // returns cost assigned to a given function block
+    static constexpr size_t function_cost(const Function &function) {
+        return COST;
+    }
 
-constexpr Bitmap simulate_function(const BlockInput &inputs,
-                                   const Function &function) {
-    switch (function) {
-    case AND:
-        return inputs[0] & inputs[1];
-    case OR:
-        return inputs[0] | inputs[1];
-    case XOR:
-        return inputs[0] ^ inputs[1];
-    case NAND:
-        return ~(inputs[0] & inputs[1]);
-    case NOR:
-        return ~(inputs[0] | inputs[1]);
-    case NXOR:
-        return ~(inputs[0] ^ inputs[1]);
-    default:
-        throw FunctionError(function);
+    static constexpr Bitmap simulate_function(const BlockInput &inputs,
+                                              const Function &function) {
+        switch (function) {
+        case AND:
+            return inputs[0] & inputs[1];
+        case OR:
+            return inputs[0] | inputs[1];
+        case XOR:
+            return inputs[0] ^ inputs[1];
+        case NAND:
+            return ~(inputs[0] & inputs[1]);
+        case NOR:
+            return ~(inputs[0] | inputs[1]);
+        case NXOR:
+            return ~(inputs[0] ^ inputs[1]);
+        default:
+            throw FunctionError(function);
+        }
     }
-}
+};
 
 #endif // STANDARD_FUNCTION_HPP
@@ -0,0 +1,419 @@
+/**
+ * Project: BIN project
+ * Author: Tomáš Kučma
+ * Year: 2022/2023
+ * Description: Contains implementation of cgp-stats, tool which parses logs
+ *  generated by CGP (in parallel) and produces CSV tables with convergence
+ *  curves and best block costs of each configuration
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// default amount of points of each convergence curve
+constexpr size_t POINT_COUNT = 100;
+
+// improvement of the best fitness logged in a given generation
+struct Record {
+    size_t generation;
+    size_t fitness;
+    std::optional<size_t> block_cost;
+};
+
+// parsed log of a single run
+struct RunLog {
+    std::string config;
+    size_t max_fitness = 0;
+    size_t max_block_cost = 0;
+    std::vector<Record> records;
+};
+
+// read only memory mapping of a file
+struct MappedFile {
+    int fd;
+    size_t size;
+    const char *data;
+
+    MappedFile(const std::string &path)
+        : fd{open(path.c_str(), O_RDONLY)}, size{0}, data{nullptr} {
+        if (fd < 0) {
+            throw std::runtime_error("Can't open " + path);
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) < 0) {
+            close(fd);
+            throw std::runtime_error("Can't stat " + path);
+        }
+        size = file_stat.st_size;
+        if (!size) {
+            return;
+        }
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Can't map " + path);
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(mapped);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        if (data) {
+            munmap(const_cast<char *>(data), size);
+        }
+        close(fd);
+    }
+
+    std::string_view view() const { return {data, size}; }
+};
+
+// returns configuration of a log, its path without the run number suffix
+// (e.g. logs/adder2b_10 for logs/adder2b_10_3.log)
+std::string get_config(const std::filesystem::path &path) {
+    std::string stem = path.stem().string();
+    const size_t separator = stem.rfind('_');
+    if (separator != std::string::npos && separator + 1 < stem.size() &&
+        std::all_of(stem.begin() + separator + 1, stem.end(),
+                    [](unsigned char c) { return std::isdigit(c); })) {
+        stem.resize(separator);
+    }
+    return (path.parent_path() / stem).string();
+}
+
+// parses number at the start of text, moving text after it
+std::optional<size_t> parse_number(std::string_view &text) {
+    size_t number;
+    auto [end, error] =
+        std::from_chars(text.data(), text.data() + text.size(), number);
+    if (error != std::errc{}) {
+        return std::nullopt;
+    }
+    text.remove_prefix(end - text.data());
+    return number;
+}
+
+// parses "fitness/max_fitness[ (block cost cost/max_cost)]"
+bool parse_fitness(std::string_view text, Record &record, RunLog &log) {
+    constexpr std::string_view block_cost = " (block cost ";
+    auto fitness = parse_number(text);
+    if (!fitness || !text.starts_with('/')) {
+        return false;
+    }
+    text.remove_prefix(1);
+    auto max_fitness = parse_number(text);
+    if (!max_fitness) {
+        return false;
+    }
+    record.fitness = *fitness;
+    log.max_fitness = *max_fitness;
+    if (text.starts_with(block_cost)) {
+        text.remove_prefix(block_cost.size());
+        auto cost = parse_number(text);
+        if (!cost || !text.starts_with('/')) {
+            return false;
+        }
+        text.remove_prefix(1);
+        auto max_cost = parse_number(text);
+        if (!max_cost) {
+            return false;
+        }
+        record.block_cost = cost;
+        log.max_block_cost = *max_cost;
+    }
+    return true;
+}
+
+// returns the best record of given records in a given generation
+const Record *get_record(const std::vector<Record> &records,
+                         size_t generation) {
+    auto iter = std::upper_bound(
+        records.begin(), records.end(), generation,
+        [](size_t generation, const Record &record) {
+            return generation < record.generation;
+        });
+    return iter == records.begin() ? nullptr : &*std::prev(iter);
+}
+
+// combines records of groups of outputs evolved in parallel into records of
+// the whole circuit, whose fitness is the sum of the fitness of the groups
+// (never with block cost, as the circuit is solved only by the joint phase)
+std::vector<Record>
+combine_group_records(const std::vector<std::vector<Record>> &group_records) {
+    std::vector<size_t> generations;
+    for (const auto &records : group_records) {
+        for (const auto &record : records) {
+            generations.push_back(record.generation);
+        }
+    }
+    std::sort(generations.begin(), generations.end());
+    generations.erase(std::unique(generations.begin(), generations.end()),
+                      generations.end());
+    std::vector<Record> combined;
+    for (const auto &generation : generations) {
+        size_t fitness = 0;
+        for (const auto &records : group_records) {
+            const Record *record = get_record(records, generation);
+            fitness += record ? record->fitness : 0;
+        }
+        combined.push_back({generation, fitness, std::nullopt});
+    }
+    return combined;
+}
+
+// parses generation and fitness of each improvement of the last evolution in
+// the log, skipping the chromosomes, for decomposed evolution the group phase
+// (combined from all the groups) is followed by the joint evolution, whose
+// generations are offset by the length of the group phase
+RunLog parse_log(const std::filesystem::path &path) {
+    constexpr std::string_view joint_evolution = "Joint evolution after ";
+    MappedFile file(path.string());
+    RunLog log{get_config(path)};
+    std::vector<std::vector<Record>> group_records;
+    std::vector<Record> *records = &log.records;
+    size_t group_generation_count = 0;
+    std::string_view text = file.view();
+    while (!text.empty()) {
+        const size_t line_end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, line_end);
+        text.remove_prefix(std::min(line_end + 1, text.size()));
+
+        if (line.starts_with("Parameters:")) { // start of a new evolution
+            records->clear();
+            continue;
+        }
+        if (line.starts_with("Decomposition:")) { // evolution of a group
+            group_records.emplace_back();
+            records = &group_records.back();
+            continue;
+        }
+        if (line.starts_with(joint_evolution)) {
+            line.remove_prefix(joint_evolution.size());
+            group_generation_count = parse_number(line).value_or(0);
+            records = &log.records;
+            continue;
+        }
+        if (line.empty() || !std::isdigit((unsigned char)line.front())) {
+            continue;
+        }
+        Record record{};
+        auto generation = parse_number(line);
+        const size_t fitness_start = line.rfind(", ");
+        if (!generation || !line.starts_with(':') ||
+            fitness_start == std::string_view::npos ||
+            !parse_fitness(line.substr(fitness_start + 2), record, log)) {
+            continue;
+        }
+        // group records aren't offset, as the count is set only after them
+        record.generation = *generation + group_generation_count;
+        records->push_back(record);
+    }
+    if (!group_records.empty()) {
+        auto combined = combine_group_records(group_records);
+        log.records.insert(log.records.begin(), combined.begin(),
+                           combined.end());
+    }
+    return log;
+}
+
+// parses logs using all available cores, returns the parsed logs
+std::vector<RunLog>
+parse_logs(const std::vector<std::filesystem::path> &paths) {
+    std::vector<RunLog> logs(paths.size());
+    std::vector<std::string> errors(paths.size());
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() {
+        for (size_t i = next_index++; i < paths.size(); i = next_index++) {
+            try {
+                logs[i] = parse_log(paths[i]);
+            } catch (const std::exception &error) {
+                errors[i] = error.what();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    const size_t thread_count =
+        std::max(std::min<size_t>(std::thread::hardware_concurrency(),
+                                  paths.size()),
+                 1UL);
+    for (size_t i = 0; i < thread_count; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<RunLog> parsed;
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!errors[i].empty()) {
+            std::cerr << errors[i] << "\n";
+        } else if (logs[i].records.empty()) {
+            std::cerr << "No generations found in " << paths[i].string()
+                      << "\n";
+        } else {
+            parsed.push_back(std::move(logs[i]));
+        }
+    }
+    return parsed;
+}
+
+// writes mean fitness, ratio of solved runs and mean block cost of the solved
+// runs of each configuration in evenly spaced generations
+void write_convergence(
+    std::ostream &out,
+    const std::map<std::string, std::vector<const RunLog *>> &configs,
+    size_t point_count) {
+    out << "config,generation,mean_fitness,max_fitness,solved_ratio,"
+           "mean_block_cost\n";
+    for (const auto &[config, logs] : configs) {
+        size_t last_generation = 1;
+        for (const auto &log : logs) {
+            last_generation =
+                std::max(last_generation, log->records.back().generation);
+        }
+        for (size_t point = 0; point < point_count; point++) {
+            const size_t generation =
+                point_count > 1 ? point * last_generation / (point_count - 1)
+                                : last_generation;
+            double fitness_sum = 0;
+            size_t solved_count = 0;
+            double cost_sum = 0;
+            for (const auto &log : logs) {
+                const Record *record = get_record(log->records, generation);
+                if (!record) {
+                    continue;
+                }
+                fitness_sum += record->fitness;
+                if (record->block_cost) {
+                    solved_count++;
+                    cost_sum += *record->block_cost;
+                }
+            }
+            out << config << "," << generation << ","
+                << fitness_sum / logs.size() << "," << logs.front()->max_fitness
+                << "," << double(solved_count) / logs.size() << ",";
+            if (solved_count) {
+                out << cost_sum / solved_count;
+            }
+            out << "\n";
+        }
+    }
+}
+
+// writes amount of solved runs, their best, mean and median block cost and
+// mean generation in which they were solved for each configuration
+void write_best_cost(
+    std::ostream &out,
+    const std::map<std::string, std::vector<const RunLog *>> &configs) {
+    out << "config,runs,solved,best_block_cost,mean_block_cost,"
+           "median_block_cost,max_block_cost,mean_solution_generation\n";
+    for (const auto &[config, logs] : configs) {
+        std::vector<size_t> costs;
+        double solution_generation_sum = 0;
+        size_t max_block_cost = 0;
+        for (const auto &log : logs) {
+            const Record &last = log->records.back();
+            if (!last.block_cost) {
+                continue;
+            }
+            costs.push_back(*last.block_cost);
+            max_block_cost = log->max_block_cost;
+            solution_generation_sum +=
+                std::find_if(log->records.begin(), log->records.end(),
+                             [](const Record &record) {
+                                 return record.block_cost.has_value();
+                             })
+                    ->generation;
+        }
+        out << config << "," << logs.size() << "," << costs.size() << ",";
+        if (costs.empty()) {
+            out << ",,,,\n";
+            continue;
+        }
+        std::sort(costs.begin(), costs.end());
+        const size_t middle = costs.size() / 2;
+        const double median = costs.size() % 2
+                                  ? costs[middle]
+                                  : (costs[middle - 1] + costs[middle]) / 2.0;
+        out << costs.front() << ","
+            << std::accumulate(costs.begin(), costs.end(), 0.0) / costs.size()
+            << "," << median << "," << max_block_cost << ","
+            << solution_generation_sum / costs.size() << "\n";
+    }
+}
+
+void print_usage(const char *program) {
+    std::cerr << "Usage: " << program
+              << " [-o OUT_FOLDER] [-p POINT_COUNT] LOG_FOLDER...\n"
+              << "Writes convergence.csv and best_cost.csv into OUT_FOLDER "
+                 "(current folder by default)\n";
+}
+
+int main(int argc, char *argv[]) {
+    std::filesystem::path out_folder{"."};
+    size_t point_count = POINT_COUNT;
+    std::vector<std::filesystem::path> paths;
+    try {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg{argv[i]};
+            if (arg == "-o" && i + 1 < argc) {
+                out_folder = argv[++i];
+            } else if (arg == "-p" && i + 1 < argc) {
+                point_count = std::stoul(argv[++i]);
+            } else if (arg.starts_with("-")) {
+                print_usage(argv[0]);
+                return 1;
+            } else {
+                for (const auto &entry :
+                     std::filesystem::directory_iterator(arg)) {
+                    if (entry.is_regular_file() &&
+                        entry.path().extension() == ".log") {
+                        paths.push_back(entry.path());
+                    }
+                }
+            }
+        }
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (paths.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const std::vector<RunLog> logs = parse_logs(paths);
+    std::map<std::string, std::vector<const RunLog *>> configs;
+    for (const auto &log : logs) {
+        configs[log.config].push_back(&log);
+    }
+
+    std::filesystem::create_directories(out_folder);
+    std::ofstream convergence(out_folder / "convergence.csv");
+    write_convergence(convergence, configs, point_count);
+    std::ofstream best_cost(out_folder / "best_cost.csv");
+    write_best_cost(best_cost, configs);
+    std::cout << "Parsed " << logs.size() << " of " << paths.size()
+              << " logs (" << configs.size() << " configurations)\n";
+    return 0;
+}
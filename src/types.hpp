@@ -8,11 +8,12 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+// widest gene, CGP itself may use a smaller type for its chromosomes
 using Gene = uint32_t;
-using Chromosome = std::vector<Gene>;
 using Bitmap = uint64_t;
 
 constexpr size_t BITMAP_SIZE = sizeof(Bitmap) * 8;